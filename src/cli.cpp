@@ -41,12 +41,20 @@ Cli CliParser::parse(int argc, char* argv[]) {
         } else if (arg == "-f" || arg == "--fan-speed-update-period") {
             if (++i >= argc) throw std::runtime_error("Missing value for fan-speed-update-period");
             cli.fan_speed_update_period = validate_fan_speed_update_period(argv[i]);
+        } else if (arg == "-a" || arg == "--adaptive-update-period") {
+            cli.adaptive_update_period = true;
         } else if (arg == "-p" || arg == "--proportional-gain") {
             if (++i >= argc) throw std::runtime_error("Missing value for proportional-gain");
             cli.proportional_gain = validate_proportional_gain(argv[i]);
         } else if (arg == "-i" || arg == "--integral-gain") {
             if (++i >= argc) throw std::runtime_error("Missing value for integral-gain");
             cli.integral_gain = validate_integral_gain(argv[i]);
+        } else if (arg == "-P" || arg == "--profiles") {
+            if (++i >= argc) throw std::runtime_error("Missing value for profiles");
+            cli.profiles_file = std::string(argv[i]);
+        } else if (arg == "-s" || arg == "--profile-switch-delay") {
+            if (++i >= argc) throw std::runtime_error("Missing value for profile-switch-delay");
+            cli.profile_switch_delay = validate_profile_switch_delay(argv[i]);
         } else {
             throw std::runtime_error("Unknown argument: " + arg);
         }
@@ -74,10 +82,18 @@ void CliParser::print_help(const std::string& program_name) {
     std::cout << "    -f, --fan-speed-update-period <SEC>  Fan speed update period (s) [default: "
               << DEFAULT_FAN_SPEED_UPDATE_PERIOD << ", range: " << MIN_FAN_SPEED_UPDATE_PERIOD
               << "-" << MAX_FAN_SPEED_UPDATE_PERIOD << "]\n";
+    std::cout << "    -a, --adaptive-update-period         Stretch the update period up to " << ADAPTIVE_MAX_UPDATE_PERIOD
+              << "s on an idle GPU and\n"
+              << "                                         shrink it to " << ADAPTIVE_MIN_UPDATE_PERIOD
+              << "s on fast temperature or power rises\n";
     std::cout << "    -p, --proportional-gain <GAIN>       PI proportional gain [default: "
               << DEFAULT_PROPORTIONAL_GAIN << "]\n";
     std::cout << "    -i, --integral-gain <GAIN>           PI integral gain [default: "
               << DEFAULT_INTEGRAL_GAIN << "]\n";
+    std::cout << "    -P, --profiles <FILE>                Per-workload tuning profiles matched against GPU processes\n";
+    std::cout << "    -s, --profile-switch-delay <SEC>     Time a new workload must persist before switching profile (s) [default: "
+              << DEFAULT_PROFILE_SWITCH_DELAY << ", range: " << MIN_PROFILE_SWITCH_DELAY
+              << "-" << MAX_PROFILE_SWITCH_DELAY << "]\n";
 }
 
 void CliParser::print_version() {
@@ -123,3 +139,13 @@ float CliParser::validate_integral_gain(const std::string& value) {
     }
     return gain;
 }
+
+unsigned int CliParser::validate_profile_switch_delay(const std::string& value) {
+    unsigned int delay = std::stoul(value);
+    if (delay < MIN_PROFILE_SWITCH_DELAY || delay > MAX_PROFILE_SWITCH_DELAY) {
+        throw std::runtime_error("Profile switch delay must be between " +
+                                std::to_string(MIN_PROFILE_SWITCH_DELAY) + " and " +
+                                std::to_string(MAX_PROFILE_SWITCH_DELAY) + " seconds");
+    }
+    return delay;
+}
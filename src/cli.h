@@ -13,8 +13,11 @@ struct Cli {
     std::optional<unsigned int> max_memory_clock;
     std::optional<unsigned int> target_temperature;
     unsigned int fan_speed_update_period = DEFAULT_FAN_SPEED_UPDATE_PERIOD;
+    bool adaptive_update_period = false;
     float proportional_gain = DEFAULT_PROPORTIONAL_GAIN;
     float integral_gain = DEFAULT_INTEGRAL_GAIN;
+    std::optional<std::string> profiles_file;
+    unsigned int profile_switch_delay = DEFAULT_PROFILE_SWITCH_DELAY;
 };
 
 class CliParser {
@@ -28,4 +31,5 @@ private:
     static unsigned int validate_fan_speed_update_period(const std::string& value);
     static float validate_proportional_gain(const std::string& value);
     static float validate_integral_gain(const std::string& value);
+    static unsigned int validate_profile_switch_delay(const std::string& value);
 };
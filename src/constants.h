@@ -12,6 +12,19 @@ constexpr unsigned int DEFAULT_FAN_SPEED_UPDATE_PERIOD = 2;  // s
 constexpr unsigned int MIN_FAN_SPEED_UPDATE_PERIOD = 1;      // s
 constexpr unsigned int MAX_FAN_SPEED_UPDATE_PERIOD = 10;     // s
 
+constexpr float ADAPTIVE_MIN_UPDATE_PERIOD = 0.5f;           // s
+constexpr float ADAPTIVE_MAX_UPDATE_PERIOD = MAX_FAN_SPEED_UPDATE_PERIOD; // s
+constexpr float ADAPTIVE_STRETCH_FACTOR = 1.5f;              // Period growth per stable step
+constexpr unsigned int ADAPTIVE_IDLE_UTILIZATION = 5;        // %
+constexpr unsigned int ADAPTIVE_IDLE_TEMPERATURE_MARGIN = 10; // °C below target
+constexpr unsigned int ADAPTIVE_STABLE_TEMPERATURE_DELTA = 1; // °C per step (sensor resolution)
+constexpr float ADAPTIVE_FAST_TEMPERATURE_SLOPE = 0.5f;      // °C/s
+constexpr float ADAPTIVE_FAST_POWER_RISE = 0.05f;            // Rise per step as a fraction of the enforced limit
+
+constexpr unsigned int DEFAULT_PROFILE_SWITCH_DELAY = 10;    // s
+constexpr unsigned int MIN_PROFILE_SWITCH_DELAY = 0;         // s
+constexpr unsigned int MAX_PROFILE_SWITCH_DELAY = 300;       // s
+
 constexpr float DEFAULT_PROPORTIONAL_GAIN = 4.0f;
 constexpr float MIN_PROPORTIONAL_GAIN = 0.1f;
 constexpr float MAX_PROPORTIONAL_GAIN = 10.0f;
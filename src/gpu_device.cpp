@@ -5,10 +5,16 @@
 #include <csignal>
 #include <cstdlib>
 #include <string>
+#include <utility>
 #include <dlfcn.h>
 
 std::shared_ptr<NvmlDevice> NvmlDevice::cleanup_device = nullptr;
 
+// Termination signals that run the cleanup handler
+static const int cleanup_signals[] = {
+    SIGINT, SIGTERM, SIGHUP, SIGALRM, SIGIO, SIGPIPE, SIGPROF, SIGUSR1, SIGUSR2, SIGVTALRM
+};
+
 NvmlDevice::NvmlDevice(nvmlDevice_t device_handle) 
     : handle(device_handle), fan_speed_state(std::make_shared<FanSpeedState>()) {}
 
@@ -63,11 +69,53 @@ void NvmlDevice::set_max_memory_clock(unsigned int clock) {
                     "set maximum memory clock");
 }
 
+void NvmlDevice::reset_max_core_clock() {
+    check_nvml_error(nvmlDeviceResetGpuLockedClocks(handle),
+                    "reset maximum core clock");
+}
+
+void NvmlDevice::reset_max_memory_clock() {
+    check_nvml_error(nvmlDeviceResetMemoryLockedClocks(handle),
+                    "reset maximum memory clock");
+}
+
 void NvmlDevice::set_power_limit(unsigned int limit) {
     check_nvml_error(nvmlDeviceSetPowerManagementLimit(handle, limit * 1000), 
                     "set power limit");
 }
 
+void NvmlDevice::set_power_limit_mw(unsigned int limit) {
+    check_nvml_error(nvmlDeviceSetPowerManagementLimit(handle, limit),
+                    "set power limit");
+}
+
+unsigned int NvmlDevice::get_default_power_limit_mw() {
+    unsigned int limit;
+    check_nvml_error(nvmlDeviceGetPowerManagementDefaultLimit(handle, &limit),
+                    "get default power limit");
+    return limit;
+}
+
+std::vector<unsigned int> NvmlDevice::get_compute_process_ids() {
+    std::vector<nvmlProcessInfo_t> infos;
+    unsigned int count = 0;
+    nvmlReturn_t result = nvmlDeviceGetComputeRunningProcesses(handle, &count, nullptr);
+
+    // Processes may start between the size query and the fetch, so leave some headroom and retry
+    while (result == NVML_ERROR_INSUFFICIENT_SIZE) {
+        infos.resize(count + 8);
+        count = static_cast<unsigned int>(infos.size());
+        result = nvmlDeviceGetComputeRunningProcesses(handle, &count, infos.data());
+    }
+    check_nvml_error(result, "get running compute processes");
+
+    std::vector<unsigned int> pids;
+    for (unsigned int i = 0; i < count && i < infos.size(); ++i) {
+        pids.push_back(infos[i].pid);
+    }
+    return pids;
+}
+
 unsigned int NvmlDevice::get_temperature() {
     unsigned int temp;
     check_nvml_error(nvmlDeviceGetTemperature(handle, NVML_TEMPERATURE_GPU, &temp), 
@@ -75,6 +123,27 @@ unsigned int NvmlDevice::get_temperature() {
     return temp;
 }
 
+unsigned int NvmlDevice::get_utilization() {
+    nvmlUtilization_t utilization;
+    check_nvml_error(nvmlDeviceGetUtilizationRates(handle, &utilization),
+                    "get utilization");
+    return utilization.gpu;
+}
+
+unsigned int NvmlDevice::get_power_usage_mw() {
+    unsigned int power;
+    check_nvml_error(nvmlDeviceGetPowerUsage(handle, &power),
+                    "get power usage");
+    return power;
+}
+
+unsigned int NvmlDevice::get_enforced_power_limit_mw() {
+    unsigned int limit;
+    check_nvml_error(nvmlDeviceGetEnforcedPowerLimit(handle, &limit),
+                    "get enforced power limit");
+    return limit;
+}
+
 unsigned int NvmlDevice::get_num_fans() {
     unsigned int num_fans;
     
@@ -129,6 +198,7 @@ void NvmlDevice::set_fan_speed(unsigned int speed) {
     if (fan_speed_state->default_set.load()) {
         return;
     }
+    fan_speed_state->manual_set.store(true);
 
     typedef nvmlReturn_t (*nvmlDeviceSetFanSpeed_v2_t)(nvmlDevice_t, unsigned int, unsigned int);
     static nvmlDeviceSetFanSpeed_v2_t func = nullptr;
@@ -176,19 +246,34 @@ void NvmlDevice::set_default_fan_speed() {
     }
 }
 
+void NvmlDevice::set_cleanup_action(std::function<void(NvmlDevice&)> action) {
+    cleanup_action = std::move(action);
+}
+
+void NvmlDevice::run_cleanup() {
+    if (!cleanup_device) {
+        return;
+    }
+
+    // Take ownership so a second signal during cleanup doesn't run it twice
+    std::shared_ptr<NvmlDevice> device = std::move(cleanup_device);
+    if (device->cleanup_action) {
+        device->cleanup_action(*device);
+    }
+    if (device->fan_speed_state->manual_set.load()) {
+        device->set_default_fan_speed();
+    }
+}
+
 void NvmlDevice::cleanup_handler(int signal) {
     std::cout << "Signal received: " << signal << std::endl;
-    if (cleanup_device) {
-        cleanup_device->set_default_fan_speed();
-    }
+    run_cleanup();
     exit(0);
 }
 
 void NvmlDevice::panic_handler() {
     std::cerr << "Panic occurred!" << std::endl;
-    if (cleanup_device) {
-        cleanup_device->set_default_fan_speed();
-    }
+    run_cleanup();
 }
 
 void NvmlDevice::setup_cleanup() {
@@ -197,16 +282,9 @@ void NvmlDevice::setup_cleanup() {
     // Set up signal handlers for various termination signals (only once)
     static bool handlers_set = false;
     if (!handlers_set) {
-        std::signal(SIGINT, cleanup_handler);
-        std::signal(SIGTERM, cleanup_handler);
-        std::signal(SIGHUP, cleanup_handler);
-        std::signal(SIGALRM, cleanup_handler);
-        std::signal(SIGIO, cleanup_handler);
-        std::signal(SIGPIPE, cleanup_handler);
-        std::signal(SIGPROF, cleanup_handler);
-        std::signal(SIGUSR1, cleanup_handler);
-        std::signal(SIGUSR2, cleanup_handler);
-        std::signal(SIGVTALRM, cleanup_handler);
+        for (int signal : cleanup_signals) {
+            std::signal(signal, cleanup_handler);
+        }
 
         // Ignore stop signals
         std::signal(SIGTSTP, SIG_IGN);
@@ -219,6 +297,19 @@ void NvmlDevice::setup_cleanup() {
     }
 }
 
+CleanupSignalBlocker::CleanupSignalBlocker() {
+    sigset_t mask;
+    sigemptyset(&mask);
+    for (int signal : cleanup_signals) {
+        sigaddset(&mask, signal);
+    }
+    sigprocmask(SIG_BLOCK, &mask, &previous_mask);
+}
+
+CleanupSignalBlocker::~CleanupSignalBlocker() {
+    sigprocmask(SIG_SETMASK, &previous_mask, nullptr);
+}
+
 void check_nvml_error(nvmlReturn_t result, const std::string& operation) {
     if (result != NVML_SUCCESS) {
         throw std::runtime_error("Failed to " + operation + ": " + 
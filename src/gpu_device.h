@@ -2,7 +2,10 @@
 
 #include <memory>
 #include <atomic>
+#include <functional>
 #include <string>
+#include <vector>
+#include <signal.h>
 
 extern "C" {
 #include <nvml.h>
@@ -10,12 +13,14 @@ extern "C" {
 
 struct FanSpeedState {
     std::atomic<bool> default_set{false};
+    std::atomic<bool> manual_set{false};
 };
 
 class NvmlDevice : public std::enable_shared_from_this<NvmlDevice> {
 private:
     nvmlDevice_t handle;
     std::shared_ptr<FanSpeedState> fan_speed_state;
+    std::function<void(NvmlDevice&)> cleanup_action;
     
 public:
     NvmlDevice(nvmlDevice_t device_handle);
@@ -25,12 +30,22 @@ public:
     void set_memory_clock_offset(int offset);
     void set_max_core_clock(unsigned int clock);
     void set_max_memory_clock(unsigned int clock);
+    void reset_max_core_clock();
+    void reset_max_memory_clock();
     void set_power_limit(unsigned int limit);
+    void set_power_limit_mw(unsigned int limit);
+    unsigned int get_default_power_limit_mw();
+    std::vector<unsigned int> get_compute_process_ids();
     unsigned int get_temperature();
+    unsigned int get_utilization();
+    unsigned int get_power_usage_mw();
+    unsigned int get_enforced_power_limit_mw();
     unsigned int get_fan_speed();
     void set_fan_speed(unsigned int speed);
     void set_default_fan_speed();
     void setup_cleanup();
+    void set_cleanup_action(std::function<void(NvmlDevice&)> action);
+    static void run_cleanup();
     
 private:
     unsigned int get_num_fans();
@@ -41,5 +56,19 @@ private:
     static std::shared_ptr<NvmlDevice> cleanup_device;
 };
 
+// Defers the cleanup signals for its lifetime, so a multi-step change to the device is
+// never interrupted halfway by the cleanup handler
+class CleanupSignalBlocker {
+private:
+    sigset_t previous_mask;
+
+public:
+    CleanupSignalBlocker();
+    ~CleanupSignalBlocker();
+
+    CleanupSignalBlocker(const CleanupSignalBlocker&) = delete;
+    CleanupSignalBlocker& operator=(const CleanupSignalBlocker&) = delete;
+};
+
 void check_nvml_error(nvmlReturn_t result, const std::string& operation);
 void check_driver_version();
@@ -1,11 +1,18 @@
 #include <iostream>
 #include <thread>
 #include <chrono>
+#include <algorithm>
 #include <csignal>
 #include <cstdlib>
+#include <memory>
+#include <optional>
+#include <vector>
+#include <stdexcept>
 
 #include "cli.h"
 #include "gpu_device.h"
+#include "profile.h"
+#include "poll_scheduler.h"
 #include "temperature_controller.h"
 #include "utils.h"
 #include "constants.h"
@@ -30,53 +37,178 @@ int main(int argc, char* argv[]) {
         auto device = std::make_shared<NvmlDevice>(device_handle);
         
         // Set overclocking parameters
-        if (cli.core_clock_offset.has_value()) {
-            device->set_core_clock_offset(cli.core_clock_offset.value());
-        }
-        
-        if (cli.memory_clock_offset.has_value()) {
-            device->set_memory_clock_offset(cli.memory_clock_offset.value());
-        }
+        TuningSettings base_settings;
+        base_settings.core_clock_offset = cli.core_clock_offset;
+        base_settings.memory_clock_offset = cli.memory_clock_offset;
+        base_settings.max_core_clock = cli.max_core_clock;
+        base_settings.max_memory_clock = cli.max_memory_clock;
+        base_settings.power_limit = cli.power_limit;
+        base_settings.target_temperature = cli.target_temperature;
 
-        if (cli.max_core_clock.has_value()) {
-            device->set_max_core_clock(cli.max_core_clock.value());
+        // Shared with the cleanup action, which restores the base settings on exit
+        auto applied_settings = std::make_shared<TuningSettings>();
+        apply_settings(*device, *applied_settings, base_settings);
+        if (*applied_settings != base_settings) {
+            throw std::runtime_error("Failed to apply the command line settings");
         }
 
-        if (cli.max_memory_clock.has_value()) {
-            device->set_max_memory_clock(cli.max_memory_clock.value());
-        }
+        std::vector<TuningProfile> profiles;
+        if (cli.profiles_file.has_value()) {
+            profiles = load_profiles(cli.profiles_file.value());
+            for (const auto& profile : profiles) {
+                if (profile.settings.target_temperature.has_value() && !cli.target_temperature.has_value()) {
+                    throw std::runtime_error("Profile [" + profile.name +
+                                             "] sets target-temperature, which requires --target-temperature");
+                }
+            }
+
+            // Don't trust that a previous run restored the settings the profiles touch
+            reset_profile_settings(*device, profiles, base_settings);
 
-        if (cli.power_limit.has_value()) {
-            device->set_power_limit(cli.power_limit.value());
+            device->set_cleanup_action([applied_settings, base_settings](NvmlDevice& cleanup_device) {
+                apply_settings(cleanup_device, *applied_settings, base_settings);
+            });
         }
-        
-        // PI temperature control
-        if (cli.target_temperature.has_value()) {
-            // Get current state for controller initialization
-            unsigned int current_temp = device->get_temperature();
-            unsigned int current_fan_speed = device->get_fan_speed();
-
-            TemperatureController controller(
-                current_temp,
-                current_fan_speed,
-                cli.target_temperature.value(),
-                MIN_FAN_SPEED,
-                MAX_FAN_SPEED,
-                cli.proportional_gain,
-                cli.integral_gain,
-                static_cast<float>(cli.fan_speed_update_period)
-            );
-            
+
+        if (cli.target_temperature.has_value() || !profiles.empty()) {
             device->setup_cleanup();
-            
-            std::cout << "Starting PI temperature control (target: "
-                      << cli.target_temperature.value() << "°C)" << std::endl;
+
+            // PI temperature control
+            std::optional<TemperatureController> controller;
+            if (cli.target_temperature.has_value()) {
+                // Get current state for controller initialization
+                unsigned int current_temp = device->get_temperature();
+                unsigned int current_fan_speed = device->get_fan_speed();
+
+                controller.emplace(
+                    current_temp,
+                    current_fan_speed,
+                    cli.target_temperature.value(),
+                    MIN_FAN_SPEED,
+                    MAX_FAN_SPEED,
+                    cli.proportional_gain,
+                    cli.integral_gain,
+                    static_cast<float>(cli.fan_speed_update_period)
+                );
+
+                std::cout << "Starting PI temperature control (target: "
+                          << cli.target_temperature.value() << "°C)" << std::endl;
+            }
+
+            ProfileSelector selector(profiles, std::chrono::seconds(cli.profile_switch_delay));
+            if (!profiles.empty()) {
+                std::cout << "Loaded " << profiles.size() << " tuning profile(s) from "
+                          << cli.profiles_file.value() << std::endl;
+            }
+
+            // Adaptive update period
+            PollScheduler scheduler(static_cast<float>(cli.fan_speed_update_period),
+                                    ADAPTIVE_MIN_UPDATE_PERIOD,
+                                    ADAPTIVE_MAX_UPDATE_PERIOD);
+            float update_period = static_cast<float>(cli.fan_speed_update_period);
+
+            // Not every board reports utilization and power, so probe once rather than failing in the loop
+            bool has_utilization = false;
+            bool has_power = false;
+            unsigned int enforced_power_limit = 0;
+            if (cli.adaptive_update_period) {
+                try {
+                    device->get_utilization();
+                    has_utilization = true;
+                } catch (const std::exception& e) {
+                    std::cerr << "Warning: " << e.what() << " (the GPU will not be treated as idle)" << std::endl;
+                }
+
+                try {
+                    device->get_power_usage_mw();
+                    enforced_power_limit = device->get_enforced_power_limit_mw();
+                    has_power = true;
+                } catch (const std::exception& e) {
+                    std::cerr << "Warning: " << e.what() << " (power rises will not shorten the update period)" << std::endl;
+                }
+            }
+
+            // Pretend the previous sample was one nominal period ago to match the controller's initial roll-back
+            auto last_update = std::chrono::steady_clock::now() -
+                std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<float>(update_period));
 
             while (true) {
-                unsigned int temperature = device->get_temperature();
-                unsigned int fan_speed = controller.calculate_fan_speed(temperature);
-                device->set_fan_speed(fan_speed);
-                std::this_thread::sleep_for(std::chrono::seconds(cli.fan_speed_update_period));
+                auto now = std::chrono::steady_clock::now();
+                // Capped so a suspend/resume doesn't dump a huge step into the integrator
+                float elapsed = std::min(std::chrono::duration<float>(now - last_update).count(),
+                                         ADAPTIVE_MAX_UPDATE_PERIOD);
+                last_update = now;
+
+                // Per-workload tuning profiles
+                if (!profiles.empty()) {
+                    // A failed NVML query keeps the current profile rather than stopping the daemon
+                    try {
+                        std::vector<GpuProcess> processes;
+                        for (unsigned int pid : device->get_compute_process_ids()) {
+                            processes.push_back({pid, utils::read_process_name(pid), utils::read_process_cmdline(pid)});
+                        }
+
+                        if (selector.update(processes)) {
+                            const TuningProfile* active = selector.active_profile();
+                            TuningSettings desired = active ? merge_settings(base_settings, active->settings)
+                                                            : base_settings;
+
+                            std::cout << "Switching to tuning profile: "
+                                      << (active ? active->name : "default") << std::endl;
+
+                            {
+                                CleanupSignalBlocker blocker;
+                                apply_settings(*device, *applied_settings, desired);
+                            }
+
+                            if (controller.has_value() && desired.target_temperature.has_value()) {
+                                controller->set_target_temperature(desired.target_temperature.value());
+                            }
+
+                            // A failed refresh keeps the previous limit rather than undoing the switch
+                            if (has_power) {
+                                try {
+                                    enforced_power_limit = device->get_enforced_power_limit_mw();
+                                } catch (const std::exception& e) {
+                                    std::cerr << "Warning: " << e.what() << std::endl;
+                                }
+                            }
+                        }
+                    } catch (const std::exception& e) {
+                        std::cerr << "Warning: " << e.what() << std::endl;
+                    }
+                }
+
+                if (controller.has_value() || cli.adaptive_update_period) {
+                    unsigned int temperature = device->get_temperature();
+
+                    if (controller.has_value()) {
+                        unsigned int fan_speed = cli.adaptive_update_period
+                            ? controller->calculate_fan_speed(temperature, elapsed)
+                            : controller->calculate_fan_speed(temperature);
+                        device->set_fan_speed(fan_speed);
+                    }
+
+                    if (cli.adaptive_update_period) {
+                        std::optional<unsigned int> utilization;
+                        std::optional<unsigned int> power;
+                        if (has_utilization) {
+                            utilization = device->get_utilization();
+                        }
+                        if (has_power) {
+                            power = device->get_power_usage_mw();
+                        }
+
+                        update_period = scheduler.update(elapsed,
+                                                         temperature,
+                                                         utilization,
+                                                         power,
+                                                         enforced_power_limit,
+                                                         applied_settings->target_temperature);
+                    }
+                }
+
+                std::this_thread::sleep_for(std::chrono::duration<float>(update_period));
             }
         }
         
@@ -85,6 +217,7 @@ int main(int argc, char* argv[]) {
         
     } catch (const std::exception& e) {
         std::cerr << "Error: " << e.what() << std::endl;
+        NvmlDevice::run_cleanup();
         nvmlShutdown();
         return 1;
     }
@@ -0,0 +1,48 @@
+#include "poll_scheduler.h"
+#include "constants.h"
+#include <algorithm>
+#include <cmath>
+
+PollScheduler::PollScheduler(float base_period, float min_period, float max_period)
+    : base_period(base_period), min_period(min_period), max_period(max_period), period(base_period) {}
+
+float PollScheduler::update(float elapsed,
+                            unsigned int current_temp,
+                            std::optional<unsigned int> utilization,
+                            std::optional<unsigned int> power,
+                            unsigned int power_limit,
+                            std::optional<unsigned int> target_temp) {
+    float temp_delta = has_previous ? static_cast<float>(current_temp) - static_cast<float>(previous_temp) : 0.0f;
+    float temp_slope = elapsed > 0.0f ? temp_delta / elapsed : 0.0f;
+    // Relative to the enforced limit so idle noise of a few watts doesn't count as a rise
+    float power_rise = (power.has_value() && previous_power.has_value() && power_limit > 0)
+        ? (static_cast<float>(power.value()) - static_cast<float>(previous_power.value())) / static_cast<float>(power_limit)
+        : 0.0f;
+
+    // Only heating needs fast control; cooling takes the normal path back to base_period
+    bool fast_rise = temp_slope > ADAPTIVE_FAST_TEMPERATURE_SLOPE
+                     && temp_delta > ADAPTIVE_STABLE_TEMPERATURE_DELTA;
+    bool power_rising = power_rise > ADAPTIVE_FAST_POWER_RISE;
+    bool stable = std::fabs(temp_delta) <= ADAPTIVE_STABLE_TEMPERATURE_DELTA;
+    bool cool = !target_temp.has_value() || current_temp + ADAPTIVE_IDLE_TEMPERATURE_MARGIN <= target_temp.value();
+    bool idle = utilization.has_value() && utilization.value() <= ADAPTIVE_IDLE_UTILIZATION && stable && cool;
+
+    if (fast_rise || power_rising) {
+        // Shrink straight to the minimum so the controller reacts within one short step
+        period = min_period;
+    } else if (idle) {
+        period = std::min(period * ADAPTIVE_STRETCH_FACTOR, max_period);
+    } else if (period > base_period) {
+        // Load has appeared: drop back to the nominal rate immediately
+        period = base_period;
+    } else {
+        // Settling after a fast change: relax back towards the nominal rate
+        period = std::min(period * ADAPTIVE_STRETCH_FACTOR, base_period);
+    }
+
+    has_previous = true;
+    previous_temp = current_temp;
+    previous_power = power;
+
+    return period;
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <optional>
+
+class PollScheduler {
+private:
+    const float base_period;  // Period for a loaded but stable GPU (seconds)
+    const float min_period;   // Period after a fast temperature or power rise (seconds)
+    const float max_period;   // Longest period for an idle GPU (seconds)
+
+    float period;
+
+    bool has_previous = false;
+    unsigned int previous_temp;
+    std::optional<unsigned int> previous_power;
+
+public:
+    PollScheduler(float base_period, float min_period, float max_period);
+
+    // Returns the period to sleep before the next sample, given the time since the last one.
+    // Power and the enforced power limit are in mW. A missing utilization reading is treated
+    // as "not idle" and a missing power reading as "no power rise".
+    float update(float elapsed,
+                 unsigned int current_temp,
+                 std::optional<unsigned int> utilization,
+                 std::optional<unsigned int> power,
+                 unsigned int power_limit,
+                 std::optional<unsigned int> target_temp);
+};
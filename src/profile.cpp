@@ -0,0 +1,240 @@
+#include "profile.h"
+#include "gpu_device.h"
+#include "constants.h"
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+
+std::string trim(const std::string& str) {
+    const char* whitespace = " \t\r\n";
+    size_t begin = str.find_first_not_of(whitespace);
+    if (begin == std::string::npos) {
+        return "";
+    }
+    size_t end = str.find_last_not_of(whitespace);
+    return str.substr(begin, end - begin + 1);
+}
+
+void set_profile_value(TuningProfile& profile, const std::string& key, const std::string& value) {
+    TuningSettings& settings = profile.settings;
+
+    if (key == "match") {
+        std::stringstream stream(value);
+        std::string pattern;
+        while (std::getline(stream, pattern, ',')) {
+            pattern = trim(pattern);
+            if (!pattern.empty()) {
+                profile.match.push_back(pattern);
+            }
+        }
+    } else if (key == "core-clock-offset") {
+        settings.core_clock_offset = std::stoi(value);
+    } else if (key == "memory-clock-offset") {
+        settings.memory_clock_offset = std::stoi(value);
+    } else if (key == "max-core-clock") {
+        settings.max_core_clock = std::stoul(value);
+    } else if (key == "max-memory-clock") {
+        settings.max_memory_clock = std::stoul(value);
+    } else if (key == "power-limit") {
+        settings.power_limit = std::stoul(value);
+    } else if (key == "target-temperature") {
+        unsigned int temp = std::stoul(value);
+        if (temp < MIN_TARGET_TEMPERATURE || temp > MAX_TARGET_TEMPERATURE) {
+            throw std::runtime_error("target-temperature must be between " +
+                                    std::to_string(MIN_TARGET_TEMPERATURE) + "°C and " +
+                                    std::to_string(MAX_TARGET_TEMPERATURE) + "°C");
+        }
+        settings.target_temperature = temp;
+    } else {
+        throw std::runtime_error("unknown key '" + key + "'");
+    }
+}
+
+// Apply a single setting if it changed, only recording it as applied on success
+template <typename T, typename Apply>
+void apply_setting(std::optional<T>& applied, const std::optional<T>& desired, Apply apply) {
+    if (desired == applied) {
+        return;
+    }
+
+    try {
+        apply(desired);
+        applied = desired;
+    } catch (const std::exception& e) {
+        std::cerr << "Warning: " << e.what() << std::endl;
+    }
+}
+
+} // namespace
+
+std::vector<TuningProfile> load_profiles(const std::string& path) {
+    std::ifstream file(path);
+    if (!file) {
+        throw std::runtime_error("Failed to open profiles file: " + path);
+    }
+
+    std::vector<TuningProfile> profiles;
+    std::string line;
+    unsigned int line_number = 0;
+
+    while (std::getline(file, line)) {
+        ++line_number;
+        const std::string location = path + ":" + std::to_string(line_number);
+
+        line = trim(line.substr(0, line.find('#')));
+        if (line.empty()) {
+            continue;
+        }
+
+        if (line.front() == '[') {
+            if (line.back() != ']' || line.size() < 3) {
+                throw std::runtime_error(location + ": invalid profile header: " + line);
+            }
+            profiles.push_back(TuningProfile{trim(line.substr(1, line.size() - 2)), {}, {}});
+            continue;
+        }
+
+        size_t eq_pos = line.find('=');
+        if (eq_pos == std::string::npos) {
+            throw std::runtime_error(location + ": expected 'key = value': " + line);
+        }
+        if (profiles.empty()) {
+            throw std::runtime_error(location + ": setting outside of a [profile] section");
+        }
+
+        try {
+            set_profile_value(profiles.back(), trim(line.substr(0, eq_pos)), trim(line.substr(eq_pos + 1)));
+        } catch (const std::logic_error&) {
+            // std::stoi/std::stoul throw invalid_argument/out_of_range
+            throw std::runtime_error(location + ": invalid value: " + line);
+        } catch (const std::runtime_error& e) {
+            throw std::runtime_error(location + ": " + e.what());
+        }
+    }
+
+    for (const auto& profile : profiles) {
+        if (profile.match.empty()) {
+            throw std::runtime_error(path + ": profile [" + profile.name + "] has no 'match' patterns");
+        }
+    }
+
+    return profiles;
+}
+
+TuningSettings merge_settings(const TuningSettings& base, const TuningSettings& profile) {
+    TuningSettings merged = base;
+    if (profile.core_clock_offset) merged.core_clock_offset = profile.core_clock_offset;
+    if (profile.memory_clock_offset) merged.memory_clock_offset = profile.memory_clock_offset;
+    if (profile.max_core_clock) merged.max_core_clock = profile.max_core_clock;
+    if (profile.max_memory_clock) merged.max_memory_clock = profile.max_memory_clock;
+    if (profile.power_limit) merged.power_limit = profile.power_limit;
+    if (profile.target_temperature) merged.target_temperature = profile.target_temperature;
+    return merged;
+}
+
+bool operator==(const TuningSettings& lhs, const TuningSettings& rhs) {
+    return lhs.core_clock_offset == rhs.core_clock_offset &&
+           lhs.memory_clock_offset == rhs.memory_clock_offset &&
+           lhs.max_core_clock == rhs.max_core_clock &&
+           lhs.max_memory_clock == rhs.max_memory_clock &&
+           lhs.power_limit == rhs.power_limit &&
+           lhs.target_temperature == rhs.target_temperature;
+}
+
+bool operator!=(const TuningSettings& lhs, const TuningSettings& rhs) {
+    return !(lhs == rhs);
+}
+
+void apply_settings(NvmlDevice& device, TuningSettings& applied, const TuningSettings& desired) {
+    applied.target_temperature = desired.target_temperature;
+
+    apply_setting(applied.core_clock_offset, desired.core_clock_offset,
+        [&](std::optional<int> offset) { device.set_core_clock_offset(offset.value_or(0)); });
+
+    apply_setting(applied.memory_clock_offset, desired.memory_clock_offset,
+        [&](std::optional<int> offset) { device.set_memory_clock_offset(offset.value_or(0)); });
+
+    apply_setting(applied.max_core_clock, desired.max_core_clock,
+        [&](std::optional<unsigned int> clock) {
+            if (clock.has_value()) {
+                device.set_max_core_clock(clock.value());
+            } else {
+                device.reset_max_core_clock();
+            }
+        });
+
+    apply_setting(applied.max_memory_clock, desired.max_memory_clock,
+        [&](std::optional<unsigned int> clock) {
+            if (clock.has_value()) {
+                device.set_max_memory_clock(clock.value());
+            } else {
+                device.reset_max_memory_clock();
+            }
+        });
+
+    apply_setting(applied.power_limit, desired.power_limit,
+        [&](std::optional<unsigned int> limit) {
+            if (limit.has_value()) {
+                device.set_power_limit(limit.value());
+            } else {
+                // The default is in mW and need not be a whole number of watts
+                device.set_power_limit_mw(device.get_default_power_limit_mw());
+            }
+        });
+}
+
+void reset_profile_settings(NvmlDevice& device, const std::vector<TuningProfile>& profiles,
+                            const TuningSettings& base) {
+    // Assume every field a profile sets may have been left behind by a previous run
+    TuningSettings stale;
+    for (const auto& profile : profiles) {
+        stale = merge_settings(stale, profile.settings);
+    }
+    stale = merge_settings(stale, base);
+
+    apply_settings(device, stale, base);
+}
+
+ProfileSelector::ProfileSelector(const std::vector<TuningProfile>& profiles,
+                                 std::chrono::seconds switch_delay)
+    : profiles(profiles), switch_delay(switch_delay) {}
+
+const TuningProfile* ProfileSelector::match(const std::vector<GpuProcess>& processes) const {
+    for (const auto& profile : profiles) {
+        for (const auto& pattern : profile.match) {
+            for (const auto& process : processes) {
+                if (process.name.find(pattern) != std::string::npos ||
+                    process.cmdline.find(pattern) != std::string::npos) {
+                    return &profile;
+                }
+            }
+        }
+    }
+    return nullptr;
+}
+
+bool ProfileSelector::update(const std::vector<GpuProcess>& processes) {
+    const TuningProfile* matched = match(processes);
+    auto now = std::chrono::steady_clock::now();
+
+    // Hysteresis: only switch once the new match has persisted for switch_delay
+    if (matched == active) {
+        candidate = active;
+        return false;
+    }
+
+    if (matched != candidate) {
+        candidate = matched;
+        candidate_since = now;
+    }
+
+    if (now - candidate_since < switch_delay) {
+        return false;
+    }
+
+    active = matched;
+    return true;
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <chrono>
+#include <optional>
+#include <string>
+#include <vector>
+
+class NvmlDevice;
+
+struct TuningSettings {
+    std::optional<int> core_clock_offset;
+    std::optional<int> memory_clock_offset;
+    std::optional<unsigned int> max_core_clock;
+    std::optional<unsigned int> max_memory_clock;
+    std::optional<unsigned int> power_limit;
+    std::optional<unsigned int> target_temperature;
+};
+
+struct TuningProfile {
+    std::string name;
+    std::vector<std::string> match;  // Substrings matched against process names and command lines
+    TuningSettings settings;
+};
+
+struct GpuProcess {
+    unsigned int pid;
+    std::string name;
+    std::string cmdline;
+};
+
+// Load profiles from an INI-style file, e.g.:
+//
+//   [inference]
+//   match = llama-server, vllm
+//   max-core-clock = 1500
+//   max-memory-clock = 10501
+//
+// Keys are the long CLI option names. Profiles are matched in file order.
+std::vector<TuningProfile> load_profiles(const std::string& path);
+
+// Overlay the values set in 'profile' on top of 'base'
+TuningSettings merge_settings(const TuningSettings& base, const TuningSettings& profile);
+
+bool operator==(const TuningSettings& lhs, const TuningSettings& rhs);
+bool operator!=(const TuningSettings& lhs, const TuningSettings& rhs);
+
+// Apply only the settings that differ between 'applied' and 'desired', resetting to
+// the driver defaults where 'desired' leaves a value unset (target temperature is not
+// sent to the device). Failures are logged rather than thrown. Each setting is recorded
+// in 'applied' as soon as it takes effect, so it always reflects the device state.
+void apply_settings(NvmlDevice& device, TuningSettings& applied, const TuningSettings& desired);
+
+// Reset every setting that any profile touches but 'base' leaves unset to the driver
+// default, in case a previous run exited while a profile was active
+void reset_profile_settings(NvmlDevice& device, const std::vector<TuningProfile>& profiles,
+                            const TuningSettings& base);
+
+class ProfileSelector {
+private:
+    const std::vector<TuningProfile>& profiles;
+    const std::chrono::seconds switch_delay;  // How long a new match must persist before switching
+
+    const TuningProfile* active = nullptr;     // nullptr means the base (CLI) settings
+    const TuningProfile* candidate = nullptr;
+    std::chrono::steady_clock::time_point candidate_since;
+
+    const TuningProfile* match(const std::vector<GpuProcess>& processes) const;
+
+public:
+    ProfileSelector(const std::vector<TuningProfile>& profiles, std::chrono::seconds switch_delay);
+
+    // Returns true if the active profile changed
+    bool update(const std::vector<GpuProcess>& processes);
+
+    const TuningProfile* active_profile() const { return active; }
+};
@@ -28,13 +28,17 @@ TemperatureController::TemperatureController(unsigned int current_temp,
 }
 
 unsigned int TemperatureController::calculate_fan_speed(unsigned int current_temp) {
+    return calculate_fan_speed(current_temp, dt);
+}
+
+unsigned int TemperatureController::calculate_fan_speed(unsigned int current_temp, float step_dt) {
     float error = static_cast<float>(current_temp) - static_cast<float>(target_temp);
 
     // Proportional term
     float p_term = kp * error;
 
-    // Integral term
-    integral_error += error * dt;
+    // Integral term (scaled by the actual step so variable sample periods integrate correctly)
+    integral_error += error * step_dt;
     float i_term = ki * integral_error;
 
     // Combine terms
@@ -56,3 +60,12 @@ unsigned int TemperatureController::calculate_fan_speed(unsigned int current_tem
 
     return static_cast<unsigned int>(std::round(output));
 }
+
+void TemperatureController::set_target_temperature(unsigned int new_target_temp) {
+    // Bumpless transfer: shift the integral so the step in the proportional term doesn't jump the fan speed
+    if (ki > 0.0f) {
+        float delta = static_cast<float>(new_target_temp) - static_cast<float>(target_temp);
+        integral_error += kp * delta / ki;
+    }
+    target_temp = new_target_temp;
+}
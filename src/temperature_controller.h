@@ -2,12 +2,12 @@
 
 class TemperatureController {
 private:
-    const unsigned int target_temp;    // Target temperature (°C)
+    unsigned int target_temp;          // Target temperature (°C)
     const unsigned int min_fan_speed;  // Minimum fan speed (%)
     const unsigned int max_fan_speed;  // Maximum fan speed (%)
     const float kp;                    // Proportional gain
     const float ki;                    // Integral gain
-    const float dt;                    // Sample time (seconds)
+    const float dt;                    // Nominal sample time (seconds)
 
     float integral_error;
 
@@ -22,4 +22,6 @@ public:
                           float dt);
 
     unsigned int calculate_fan_speed(unsigned int current_temp);
+    unsigned int calculate_fan_speed(unsigned int current_temp, float step_dt);
+    void set_target_temperature(unsigned int new_target_temp);
 };
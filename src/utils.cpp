@@ -1,6 +1,8 @@
 #include "utils.h"
 #include <stdexcept>
 #include <cstdlib>
+#include <fstream>
+#include <iterator>
 #include <unistd.h>
 #include <sys/wait.h>
 
@@ -40,4 +42,27 @@ bool escalate_privileges() {
     return false;
 }
 
+std::string read_process_name(unsigned int pid) {
+    std::ifstream file("/proc/" + std::to_string(pid) + "/comm");
+    std::string name;
+    std::getline(file, name);
+    return name; // Empty if the process has already exited
+}
+
+std::string read_process_cmdline(unsigned int pid) {
+    std::ifstream file("/proc/" + std::to_string(pid) + "/cmdline");
+    std::string cmdline((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    // Arguments are NUL-separated (and NUL-terminated)
+    while (!cmdline.empty() && cmdline.back() == '\0') {
+        cmdline.pop_back();
+    }
+    for (char& c : cmdline) {
+        if (c == '\0') {
+            c = ' ';
+        }
+    }
+    return cmdline;
+}
+
 } // namespace utils
@@ -5,4 +5,6 @@
 namespace utils {
     bool command_exists(const std::string& command);
     bool escalate_privileges();
+    std::string read_process_name(unsigned int pid);
+    std::string read_process_cmdline(unsigned int pid);
 }